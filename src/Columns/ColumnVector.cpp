@@ -845,6 +845,24 @@ void ColumnVector<T>::getExtremes(Field & min, Field & max) const
         return;
     }
 
+    if constexpr (!std::is_floating_point_v<T>)
+    {
+        /// There are no NaNs to skip, so the reduction can be written with plain
+        /// min/max accumulators over the raw data, which the compiler vectorizes.
+        T cur_min = data[0];
+        T cur_max = data[0];
+
+        for (size_t i = 1; i < size; ++i)
+        {
+            cur_min = std::min(cur_min, data[i]);
+            cur_max = std::max(cur_max, data[i]);
+        }
+
+        min = NearestFieldType<T>(cur_min);
+        max = NearestFieldType<T>(cur_max);
+        return;
+    }
+
     bool has_value = false;
 
     /** Skip all NaNs in extremes calculation.
@@ -3,6 +3,7 @@
 #include <Columns/ColumnConst.h>
 #include <Columns/ColumnNullable.h>
 #include <Columns/ColumnTuple.h>
+#include <Columns/ColumnsNumber.h>
 #include <Functions/FunctionHelpers.h>
 
 
@@ -237,11 +238,68 @@ void stableGetPermutation(const Block & block, const SortDescription & descripti
     getBlockSortPermutationImpl(block, description, IColumn::PermutationSortStability::Stable, 0, out_permutation);
 }
 
+namespace
+{
+
+/// Neighbour compare over the raw column data, chunked so that the inner loop is
+/// branchless and can be vectorized by the compiler while still exiting early on
+/// the first unsorted chunk.
+template <typename T>
+bool isNonDecreasing(const PaddedPODArray<T> & data)
+{
+    size_t size = data.size();
+    if (size <= 1)
+        return true;
+
+    static constexpr size_t chunk_size = 64;
+    size_t i = 1;
+    for (; i + chunk_size <= size; i += chunk_size)
+    {
+        bool sorted = true;
+        for (size_t j = i; j < i + chunk_size; ++j)
+            sorted &= data[j - 1] <= data[j];
+        if (!sorted)
+            return false;
+    }
+
+    for (; i < size; ++i)
+        if (data[i - 1] > data[i])
+            return false;
+
+    return true;
+}
+
+}
+
 bool isAlreadySorted(const Block & block, const SortDescription & description)
 {
     if (!block)
         return true;
 
+    /// Fast path for the common case of a single ascending integer sort column
+    /// without collation: compare the raw data instead of calling compareAt per row.
+    if (description.size() == 1 && description[0].direction == 1 && !isCollationRequired(description[0]))
+    {
+        const IColumn * column = block.getByName(description[0].column_name).column.get();
+
+        if (const auto * column_uint8 = typeid_cast<const ColumnUInt8 *>(column))
+            return isNonDecreasing(column_uint8->getData());
+        if (const auto * column_uint16 = typeid_cast<const ColumnUInt16 *>(column))
+            return isNonDecreasing(column_uint16->getData());
+        if (const auto * column_uint32 = typeid_cast<const ColumnUInt32 *>(column))
+            return isNonDecreasing(column_uint32->getData());
+        if (const auto * column_uint64 = typeid_cast<const ColumnUInt64 *>(column))
+            return isNonDecreasing(column_uint64->getData());
+        if (const auto * column_int8 = typeid_cast<const ColumnInt8 *>(column))
+            return isNonDecreasing(column_int8->getData());
+        if (const auto * column_int16 = typeid_cast<const ColumnInt16 *>(column))
+            return isNonDecreasing(column_int16->getData());
+        if (const auto * column_int32 = typeid_cast<const ColumnInt32 *>(column))
+            return isNonDecreasing(column_int32->getData());
+        if (const auto * column_int64 = typeid_cast<const ColumnInt64 *>(column))
+            return isNonDecreasing(column_int64->getData());
+    }
+
     size_t rows = block.rows();
 
     ColumnsWithSortDescriptions columns_with_sort_desc = getColumnsWithSortDescription(block, description);
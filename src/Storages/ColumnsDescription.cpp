@@ -533,6 +533,16 @@ NamesAndTypesList ColumnsDescription::getAllPhysical() const
     return ret;
 }
 
+NamesAndTypesList ColumnsDescription::getAllPhysical(const NameSet & names) const
+{
+    NamesAndTypesList ret;
+    for (const auto & col : columns)
+        if (col.default_desc.kind != ColumnDefaultKind::Alias && col.default_desc.kind != ColumnDefaultKind::Ephemeral
+            && names.contains(col.name))
+            ret.emplace_back(col.name, col.type);
+    return ret;
+}
+
 Names ColumnsDescription::getNamesOfPhysical() const
 {
     Names ret;
@@ -132,6 +132,9 @@ public:
     NamesAndTypesList getAliases() const;
     NamesAndTypesList getEphemeral() const;
     NamesAndTypesList getAllPhysical() const; /// ordinary + materialized.
+    /// The same, restricted to the given names. Avoids materializing
+    /// the full physical column list just to filter it afterwards.
+    NamesAndTypesList getAllPhysical(const NameSet & names) const;
     NamesAndTypesList getAll() const; /// ordinary + materialized + aliases + ephemeral
     /// Returns .size0/.null/...
     NamesAndTypesList getSubcolumns(const String & name_in_storage) const;
@@ -4,6 +4,8 @@
 #include <Columns/ColumnConst.h>
 #include <Common/HashTable/HashMap.h>
 #include <Common/Exception.h>
+#include <Common/CurrentThread.h>
+#include <Common/ThreadPool.h>
 #include <Disks/createVolume.h>
 #include <Interpreters/AggregationCommon.h>
 #include <Interpreters/Context.h>
@@ -15,10 +17,15 @@
 #include <DataTypes/ObjectUtils.h>
 #include <IO/WriteHelpers.h>
 #include <Common/typeid_cast.h>
-#include <Processors/TTL/ITTLAlgorithm.h>
 
 #include <Parsers/queryToString.h>
 
+#include <filesystem>
+
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
 #include <Processors/Merges/Algorithms/ReplacingSortedAlgorithm.h>
 #include <Processors/Merges/Algorithms/MergingSortedAlgorithm.h>
 #include <Processors/Merges/Algorithms/CollapsingSortedAlgorithm.h>
@@ -28,6 +35,8 @@
 #include <Processors/Merges/Algorithms/GraphiteRollupSortedAlgorithm.h>
 #include <Processors/Sources/SourceFromSingleChunk.h>
 
+namespace fs = std::filesystem;
+
 namespace ProfileEvents
 {
     extern const Event MergeTreeDataWriterBlocks;
@@ -54,18 +63,181 @@ namespace ErrorCodes
 namespace
 {
 
+[[noreturn]] void throwTooManyPartitions(size_t max_parts)
+{
+    throw Exception("Too many partitions for single INSERT block (more than " + toString(max_parts) + "). The limit is controlled by 'max_partitions_per_insert_block' setting. Large number of partitions is a common misconception. It will lead to severe negative performance impact, including slow server startup, slow INSERT queries and slow SELECT queries. Recommended total number of partitions for a table is under 1000..10000. Please note, that partitioning is not intended to speed up SELECT queries (ORDER BY key is sufficient to make range queries fast). Partitions are intended for data manipulation (DROP PARTITION, etc).", ErrorCodes::TOO_MANY_PARTS);
+}
+
+/// Common implementation of the typed fast paths below. The partition key of row i
+/// is get_key(i), an integer that fits into the hash map natively, so a map cell is
+/// a fraction of the size of a cell keyed by UInt128 (the mapped partition number is
+/// UInt32, which max_partitions_per_insert_block cannot overflow).
+template <typename Key, typename GetKey>
+void buildScatterSelectorWithKeys(
+        size_t num_rows,
+        GetKey && get_key,
+        PODArray<size_t> & partition_num_to_first_row,
+        IColumn::Selector & selector,
+        size_t max_parts)
+{
+    /// CRC32-based hash is a single instruction per key on SSE 4.2 and AArch64
+    /// and is good enough here: the map is per-INSERT and the keys are not adversarial.
+    using Data = HashMap<Key, UInt32, HashCRC32<Key>>;
+    Data partitions_map;
+    /// Avoid rehashing inside the hot loop: the number of partitions is bounded.
+    partitions_map.reserve(std::min<size_t>(num_rows, max_parts ? max_parts : 1024));
+
+    size_t partitions_count = 0;
+
+    /// First pass only collects the distinct partition values, so for the common
+    /// case of a single partition no selector is allocated and the hot loop has
+    /// no per-row branch on partitions_count.
+    for (size_t i = 0; i < num_rows; ++i)
+    {
+        typename Data::LookupResult it;
+        bool inserted;
+        partitions_map.emplace(get_key(i), it, inserted);
+
+        if (inserted)
+        {
+            if (max_parts && partitions_count >= max_parts)
+                throwTooManyPartitions(max_parts);
+
+            partition_num_to_first_row.push_back(i);
+            it->getMapped() = static_cast<UInt32>(partitions_count);
+
+            ++partitions_count;
+        }
+    }
+
+    if (partitions_count == 1)
+        return;
+
+    /// Second pass fills the selector from the now-complete map. All rows before
+    /// the first row of the second partition belong to partition 0.
+    selector = IColumn::Selector(num_rows);
+    size_t second_partition_first_row = partition_num_to_first_row[1];
+    std::fill(selector.begin(), selector.begin() + second_partition_first_row, 0);
+    for (size_t i = second_partition_first_row; i < num_rows; ++i)
+        selector[i] = partitions_map.find(get_key(i))->getMapped();
+}
+
+/// The same as the generic path of buildScatterSelector, but for a single numeric
+/// partition column (toYYYYMM(date), toDate(...), etc.): reads the raw column data
+/// directly and probes a hash map keyed by the native value instead of doing
+/// several virtual calls and a 128-bit hash per row.
+template <typename T>
+void buildScatterSelectorForColumn(
+        const PaddedPODArray<T> & values,
+        PODArray<size_t> & partition_num_to_first_row,
+        IColumn::Selector & selector,
+        size_t max_parts)
+{
+    buildScatterSelectorWithKeys<T>(
+        values.size(),
+        [&](size_t i) { return values[i]; },
+        partition_num_to_first_row, selector, max_parts);
+}
+
+/// Two partition columns of at most 32-bit unsigned types pack losslessly into a single UInt64 key.
+template <typename T1, typename T2>
+void buildScatterSelectorForTwoColumns(
+        const PaddedPODArray<T1> & left,
+        const PaddedPODArray<T2> & right,
+        PODArray<size_t> & partition_num_to_first_row,
+        IColumn::Selector & selector,
+        size_t max_parts)
+{
+    buildScatterSelectorWithKeys<UInt64>(
+        left.size(),
+        [&](size_t i) { return (UInt64(left[i]) << 32) | UInt64(right[i]); },
+        partition_num_to_first_row, selector, max_parts);
+}
+
+template <typename T1>
+bool tryBuildScatterSelectorForSecondColumn(
+        const PaddedPODArray<T1> & left,
+        const IColumn * right,
+        PODArray<size_t> & partition_num_to_first_row,
+        IColumn::Selector & selector,
+        size_t max_parts)
+{
+    if (const auto * column_uint8 = typeid_cast<const ColumnUInt8 *>(right))
+    {
+        buildScatterSelectorForTwoColumns(left, column_uint8->getData(), partition_num_to_first_row, selector, max_parts);
+        return true;
+    }
+    if (const auto * column_uint16 = typeid_cast<const ColumnUInt16 *>(right))
+    {
+        buildScatterSelectorForTwoColumns(left, column_uint16->getData(), partition_num_to_first_row, selector, max_parts);
+        return true;
+    }
+    if (const auto * column_uint32 = typeid_cast<const ColumnUInt32 *>(right))
+    {
+        buildScatterSelectorForTwoColumns(left, column_uint32->getData(), partition_num_to_first_row, selector, max_parts);
+        return true;
+    }
+    return false;
+}
+
+bool tryBuildScatterSelectorForTwoColumns(
+        const IColumn * left,
+        const IColumn * right,
+        PODArray<size_t> & partition_num_to_first_row,
+        IColumn::Selector & selector,
+        size_t max_parts)
+{
+    if (const auto * column_uint8 = typeid_cast<const ColumnUInt8 *>(left))
+        return tryBuildScatterSelectorForSecondColumn(column_uint8->getData(), right, partition_num_to_first_row, selector, max_parts);
+    if (const auto * column_uint16 = typeid_cast<const ColumnUInt16 *>(left))
+        return tryBuildScatterSelectorForSecondColumn(column_uint16->getData(), right, partition_num_to_first_row, selector, max_parts);
+    if (const auto * column_uint32 = typeid_cast<const ColumnUInt32 *>(left))
+        return tryBuildScatterSelectorForSecondColumn(column_uint32->getData(), right, partition_num_to_first_row, selector, max_parts);
+    return false;
+}
+
 void buildScatterSelector(
         const ColumnRawPtrs & columns,
         PODArray<size_t> & partition_num_to_first_row,
         IColumn::Selector & selector,
         size_t max_parts)
 {
+    if (columns.size() == 1)
+    {
+        const IColumn * column = columns[0];
+
+        if (const auto * column_uint16 = typeid_cast<const ColumnUInt16 *>(column))
+            return buildScatterSelectorForColumn(column_uint16->getData(), partition_num_to_first_row, selector, max_parts);
+        if (const auto * column_uint32 = typeid_cast<const ColumnUInt32 *>(column))
+            return buildScatterSelectorForColumn(column_uint32->getData(), partition_num_to_first_row, selector, max_parts);
+        if (const auto * column_uint64 = typeid_cast<const ColumnUInt64 *>(column))
+            return buildScatterSelectorForColumn(column_uint64->getData(), partition_num_to_first_row, selector, max_parts);
+        if (const auto * column_int32 = typeid_cast<const ColumnInt32 *>(column))
+            return buildScatterSelectorForColumn(column_int32->getData(), partition_num_to_first_row, selector, max_parts);
+        if (const auto * column_int64 = typeid_cast<const ColumnInt64 *>(column))
+            return buildScatterSelectorForColumn(column_int64->getData(), partition_num_to_first_row, selector, max_parts);
+    }
+
+    if (columns.size() == 2
+        && tryBuildScatterSelectorForTwoColumns(columns[0], columns[1], partition_num_to_first_row, selector, max_parts))
+        return;
+
     /// Use generic hashed variant since partitioning is unlikely to be a bottleneck.
     using Data = HashMap<UInt128, size_t, UInt128TrivialHash>;
     Data partitions_map;
 
     size_t num_rows = columns[0]->size();
     size_t partitions_count = 0;
+
+    /// Hashing the key columns dominates the per-row cost here, so the partition
+    /// number of every row is remembered during the first pass instead of
+    /// re-hashing in the second one. UInt32 is enough: max_partitions_per_insert_block
+    /// cannot overflow it.
+    PODArray<UInt32> row_to_partition_num(num_rows);
+
+    /// First pass only collects the distinct partition keys, so for the common
+    /// case of a single partition no selector is allocated and the hot loop has
+    /// no per-row branch on partitions_count.
     for (size_t i = 0; i < num_rows; ++i)
     {
         Data::key_type key = hash128(i, columns.size(), columns);
@@ -76,46 +248,206 @@ void buildScatterSelector(
         if (inserted)
         {
             if (max_parts && partitions_count >= max_parts)
-                throw Exception("Too many partitions for single INSERT block (more than " + toString(max_parts) + "). The limit is controlled by 'max_partitions_per_insert_block' setting. Large number of partitions is a common misconception. It will lead to severe negative performance impact, including slow server startup, slow INSERT queries and slow SELECT queries. Recommended total number of partitions for a table is under 1000..10000. Please note, that partitioning is not intended to speed up SELECT queries (ORDER BY key is sufficient to make range queries fast). Partitions are intended for data manipulation (DROP PARTITION, etc).", ErrorCodes::TOO_MANY_PARTS);
+                throwTooManyPartitions(max_parts);
 
             partition_num_to_first_row.push_back(i);
             it->getMapped() = partitions_count;
 
             ++partitions_count;
+        }
+
+        row_to_partition_num[i] = static_cast<UInt32>(it->getMapped());
+    }
+
+    if (partitions_count == 1)
+        return;
+
+    /// Second pass fills the selector from the cached partition numbers. All rows
+    /// before the first row of the second partition belong to partition 0.
+    selector = IColumn::Selector(num_rows);
+    size_t second_partition_first_row = partition_num_to_first_row[1];
+    std::fill(selector.begin(), selector.begin() + second_partition_first_row, 0);
+    for (size_t i = second_partition_first_row; i < num_rows; ++i)
+        selector[i] = row_to_partition_num[i];
+}
+
+/// Chunked strict neighbour compare over the raw column data: the inner loop is
+/// branchless so the compiler can vectorize it, with an early exit per chunk.
+/// Used to prove that a sorted block has no equal sort keys at all.
+template <typename T>
+bool isStrictlyIncreasing(const PaddedPODArray<T> & data)
+{
+    size_t size = data.size();
+    if (size <= 1)
+        return true;
+
+    static constexpr size_t chunk_size = 64;
+    size_t i = 1;
+    for (; i + chunk_size <= size; i += chunk_size)
+    {
+        bool increasing = true;
+        for (size_t j = i; j < i + chunk_size; ++j)
+            increasing &= data[j - 1] < data[j];
+        if (!increasing)
+            return false;
+    }
+
+    for (; i < size; ++i)
+        if (data[i - 1] >= data[i])
+            return false;
+
+    return true;
+}
+
+bool hasStrictlyIncreasingColumn(const Block & block, const String & column_name)
+{
+    const IColumn * column = block.getByName(column_name).column.get();
+
+    if (const auto * column_uint16 = typeid_cast<const ColumnUInt16 *>(column))
+        return isStrictlyIncreasing(column_uint16->getData());
+    if (const auto * column_uint32 = typeid_cast<const ColumnUInt32 *>(column))
+        return isStrictlyIncreasing(column_uint32->getData());
+    if (const auto * column_uint64 = typeid_cast<const ColumnUInt64 *>(column))
+        return isStrictlyIncreasing(column_uint64->getData());
+    if (const auto * column_int32 = typeid_cast<const ColumnInt32 *>(column))
+        return isStrictlyIncreasing(column_int32->getData());
+    if (const auto * column_int64 = typeid_cast<const ColumnInt64 *>(column))
+        return isStrictlyIncreasing(column_int64->getData());
+
+    return false;
+}
+
+/// IColumn::operator[] returns a boxed Field through a virtual call; for the
+/// typical numeric partition columns extract the value from the raw data directly.
+Field getPartitionValue(const IColumn & column, size_t row)
+{
+    if (const auto * column_uint16 = typeid_cast<const ColumnUInt16 *>(&column))
+        return static_cast<UInt64>(column_uint16->getData()[row]);
+    if (const auto * column_uint32 = typeid_cast<const ColumnUInt32 *>(&column))
+        return static_cast<UInt64>(column_uint32->getData()[row]);
+    if (const auto * column_uint64 = typeid_cast<const ColumnUInt64 *>(&column))
+        return column_uint64->getData()[row];
+    if (const auto * column_int32 = typeid_cast<const ColumnInt32 *>(&column))
+        return static_cast<Int64>(column_int32->getData()[row]);
+    if (const auto * column_int64 = typeid_cast<const ColumnInt64 *>(&column))
+        return column_int64->getData()[row];
+
+    return column[row];
+}
+
+/// Min/max over the raw column data. Written with plain accumulators over
+/// contiguous memory (with an explicit SSE path for the column types produced
+/// by TTL expressions) instead of updating the TTL info struct per row.
+/// The column must not be empty.
+template <typename T>
+std::pair<T, T> minMax(const PaddedPODArray<T> & values)
+{
+    size_t size = values.size();
+    const T * data = values.data();
+
+    T min = data[0];
+    T max = data[0];
+    size_t i = 1;
+
+#if defined(__SSE4_1__)
+    if constexpr (std::is_same_v<T, UInt32> || std::is_same_v<T, UInt16>)
+    {
+        constexpr size_t lanes = sizeof(__m128i) / sizeof(T);
+        if (size >= lanes * 2)
+        {
+            __m128i vmin = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+            __m128i vmax = vmin;
 
-            /// Optimization for common case when there is only one partition - defer selector initialization.
-            if (partitions_count == 2)
+            for (i = lanes; i + lanes <= size; i += lanes)
             {
-                selector = IColumn::Selector(num_rows);
-                std::fill(selector.begin(), selector.begin() + i, 0);
+                __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+                if constexpr (std::is_same_v<T, UInt32>)
+                {
+                    vmin = _mm_min_epu32(vmin, value);
+                    vmax = _mm_max_epu32(vmax, value);
+                }
+                else
+                {
+                    vmin = _mm_min_epu16(vmin, value);
+                    vmax = _mm_max_epu16(vmax, value);
+                }
             }
+
+            alignas(16) T lane_values[lanes];
+            _mm_store_si128(reinterpret_cast<__m128i *>(lane_values), vmin);
+            for (size_t lane = 0; lane < lanes; ++lane)
+                min = std::min(min, lane_values[lane]);
+            _mm_store_si128(reinterpret_cast<__m128i *>(lane_values), vmax);
+            for (size_t lane = 0; lane < lanes; ++lane)
+                max = std::max(max, lane_values[lane]);
         }
+    }
+#endif
 
-        if (partitions_count > 1)
-            selector[i] = it->getMapped();
+    for (; i < size; ++i)
+    {
+        min = std::min(min, data[i]);
+        max = std::max(max, data[i]);
     }
+
+    return {min, max};
 }
 
-/// Computes ttls and updates ttl infos
+/// Computes ttls and updates ttl infos.
+/// All TTL expressions of a part are executed over a scratch block shared between the
+/// updateTTL calls, so the required source columns are inserted into a scratch block
+/// (and equal expressions are executed) once per part instead of once per TTL entry.
 void updateTTL(
     const TTLDescription & ttl_entry,
     IMergeTreeDataPart::TTLInfos & ttl_infos,
     DB::MergeTreeDataPartTTLInfo & ttl_info,
     const Block & block,
+    Block & ttl_columns_scratch,
     bool update_part_min_max_ttls)
 {
-    auto ttl_column = ITTLAlgorithm::executeExpressionAndGetColumn(ttl_entry.expression, block, ttl_entry.result_column);
+    ColumnPtr ttl_column;
+    if (block.has(ttl_entry.result_column))
+    {
+        ttl_column = block.getByName(ttl_entry.result_column).column;
+    }
+    else
+    {
+        if (!ttl_columns_scratch.has(ttl_entry.result_column))
+        {
+            for (const auto & column_name : ttl_entry.expression->getRequiredColumns())
+                if (!ttl_columns_scratch.has(column_name))
+                    ttl_columns_scratch.insert(block.getByName(column_name));
+
+            /// Keep number of rows for const expression.
+            size_t num_rows = block.rows();
+            ttl_entry.expression->execute(ttl_columns_scratch, num_rows);
+        }
+
+        ttl_column = ttl_columns_scratch.getByName(ttl_entry.result_column).column;
+    }
 
     if (const ColumnUInt16 * column_date = typeid_cast<const ColumnUInt16 *>(ttl_column.get()))
     {
-        const auto & date_lut = DateLUT::instance();
-        for (const auto & val : column_date->getData())
-            ttl_info.update(date_lut.fromDayNum(DayNum(val)));
+        if (!column_date->empty())
+        {
+            /// fromDayNum is monotonic, so the min/max timestamps correspond to the
+            /// min/max day numbers. Reduce the raw day numbers first and do only two
+            /// LUT lookups instead of a dependent table load per row.
+            const auto & date_lut = DateLUT::instance();
+            auto [min, max] = minMax(column_date->getData());
+            ttl_info.update(date_lut.fromDayNum(DayNum(min)));
+            ttl_info.update(date_lut.fromDayNum(DayNum(max)));
+        }
     }
     else if (const ColumnUInt32 * column_date_time = typeid_cast<const ColumnUInt32 *>(ttl_column.get()))
     {
-        for (const auto & val : column_date_time->getData())
-            ttl_info.update(val);
+        if (!column_date_time->empty())
+        {
+            /// ttl_info.update is a min/max reduction, so it is enough to feed it the column extremes.
+            auto [min, max] = minMax(column_date_time->getData());
+            ttl_info.update(min);
+            ttl_info.update(max);
+        }
     }
     else if (const ColumnConst * column_const = typeid_cast<const ColumnConst *>(ttl_column.get()))
     {
@@ -138,6 +470,51 @@ void updateTTL(
         ttl_infos.updatePartMinMaxTTL(ttl_info.min, ttl_info.max);
 }
 
+/// A single TTL entry together with its target info inside the part.
+struct TTLUpdateTask
+{
+    const TTLDescription * entry;
+    MergeTreeDataPartTTLInfo * info;
+    bool update_part_min_max_ttls;
+};
+
+/// Computes a batch of TTL entries, in parallel when there is more than one:
+/// the entries are independent of each other, every task writes into a distinct
+/// MergeTreeDataPartTTLInfo. The fold into the part-level min/max mutates shared
+/// state, so it is done serially after all entries are computed.
+void updateTTLs(
+    const std::vector<TTLUpdateTask> & tasks,
+    IMergeTreeDataPart::TTLInfos & ttl_infos,
+    const Block & block,
+    Block & ttl_columns_scratch)
+{
+    if (tasks.size() < 2)
+    {
+        for (const auto & task : tasks)
+            updateTTL(*task.entry, ttl_infos, *task.info, block, ttl_columns_scratch, task.update_part_min_max_ttls);
+        return;
+    }
+
+    static constexpr size_t max_ttl_update_threads = 4;
+
+    ThreadPool pool(std::min(tasks.size(), max_ttl_update_threads));
+    for (const auto & task : tasks)
+        pool.scheduleOrThrowOnError([&, task, thread_group = CurrentThread::getGroup()]
+        {
+            if (thread_group)
+                CurrentThread::attachToIfDetached(thread_group);
+
+            /// The expressions execute concurrently, so each task gets its own scratch block.
+            Block scratch;
+            updateTTL(*task.entry, ttl_infos, *task.info, block, scratch, false);
+        });
+    pool.wait();
+
+    for (const auto & task : tasks)
+        if (task.update_part_min_max_ttls)
+            ttl_infos.updatePartMinMaxTTL(task.info->min, task.info->max);
+}
+
 }
 
 void MergeTreeDataWriter::TemporaryPart::finalize()
@@ -161,18 +538,31 @@ BlocksWithPartition MergeTreeDataWriter::splitBlockIntoParts(
         return result;
     }
 
-    Block block_copy = block;
-    /// After expression execution partition key columns will be added to block_copy with names regarding partition function.
-    auto partition_key_names_and_types = MergeTreePartition::executePartitionByExpression(metadata_snapshot, block_copy, context);
+    /// The partition-by expression is executed on a block with only its required columns,
+    /// so the block itself does not have to be copied here.
+    Columns partition_columns = MergeTreePartition::executePartitionByExpressionGetColumns(metadata_snapshot, block, context);
 
-    ColumnRawPtrs partition_columns;
-    partition_columns.reserve(partition_key_names_and_types.size());
-    for (const auto & element : partition_key_names_and_types)
-        partition_columns.emplace_back(block_copy.getByName(element.name).column.get());
+    /// A block with a single row trivially belongs to a single partition: take the
+    /// partition value from the only row without building the scatter selector.
+    /// This matters for workloads that stream row-at-a-time inserts.
+    if (block.rows() == 1)
+    {
+        Row partition(partition_columns.size());
+        for (size_t i = 0; i < partition_columns.size(); ++i)
+            partition[i] = getPartitionValue(*partition_columns[i], 0);
+
+        result.emplace_back(Block(block), std::move(partition));
+        return result;
+    }
+
+    ColumnRawPtrs partition_raw_columns;
+    partition_raw_columns.reserve(partition_columns.size());
+    for (const auto & column : partition_columns)
+        partition_raw_columns.emplace_back(column.get());
 
     PODArray<size_t> partition_num_to_first_row;
     IColumn::Selector selector;
-    buildScatterSelector(partition_columns, partition_num_to_first_row, selector, max_parts);
+    buildScatterSelector(partition_raw_columns, partition_num_to_first_row, selector, max_parts);
 
     size_t partitions_count = partition_num_to_first_row.size();
     result.reserve(partitions_count);
@@ -181,15 +571,13 @@ BlocksWithPartition MergeTreeDataWriter::splitBlockIntoParts(
     {
         Row partition(partition_columns.size());
         for (size_t i = 0; i < partition_columns.size(); ++i)
-            partition[i] = (*partition_columns[i])[partition_num_to_first_row[num]];
+            partition[i] = getPartitionValue(*partition_columns[i], partition_num_to_first_row[num]);
         return partition;
     };
 
     if (partitions_count == 1)
     {
         /// A typical case is when there is one partition (you do not need to split anything).
-        /// NOTE: returning a copy of the original block so that calculated partition key columns
-        /// do not interfere with possible calculated primary key columns of the same name.
         result.emplace_back(Block(block), get_partition(0));
         return result;
     }
@@ -197,11 +585,67 @@ BlocksWithPartition MergeTreeDataWriter::splitBlockIntoParts(
     for (size_t i = 0; i < partitions_count; ++i)
         result.emplace_back(block.cloneEmpty(), get_partition(i));
 
-    for (size_t col = 0; col < block.columns(); ++col)
+    /// For a small number of partitions it is faster to group the row indexes by
+    /// partition once and gather every output column with sequential writes than
+    /// to scatter each column into partitions_count interleaved write streams.
+    static constexpr size_t max_partitions_for_grouped_gather = 16;
+    std::vector<ColumnUInt32::MutablePtr> partition_row_indexes;
+    if (partitions_count <= max_partitions_for_grouped_gather)
     {
-        MutableColumns scattered = block.getByPosition(col).column->scatter(partitions_count, selector);
+        size_t num_rows = block.rows();
+
+        PODArray<size_t> rows_per_partition;
+        rows_per_partition.resize_fill(partitions_count);
+        for (auto partition_num : selector)
+            ++rows_per_partition[partition_num];
+
+        partition_row_indexes.resize(partitions_count);
         for (size_t i = 0; i < partitions_count; ++i)
-            result[i].block.getByPosition(col).column = std::move(scattered[i]);
+        {
+            partition_row_indexes[i] = ColumnUInt32::create();
+            partition_row_indexes[i]->getData().reserve(rows_per_partition[i]);
+        }
+
+        for (size_t i = 0; i < num_rows; ++i)
+            partition_row_indexes[selector[i]]->getData().push_back(static_cast<UInt32>(i));
+    }
+
+    auto split_column = [&](size_t col)
+    {
+        const auto & column = block.getByPosition(col).column;
+        if (!partition_row_indexes.empty())
+        {
+            for (size_t i = 0; i < partitions_count; ++i)
+                result[i].block.getByPosition(col).column = column->index(*partition_row_indexes[i], 0);
+        }
+        else
+        {
+            MutableColumns scattered = column->scatter(partitions_count, selector);
+            for (size_t i = 0; i < partitions_count; ++i)
+                result[i].block.getByPosition(col).column = std::move(scattered[i]);
+        }
+    };
+
+    /// Columns are split independently of each other, so for wide blocks the work
+    /// can be spread over a thread pool. Disabled by default: max_insert_threads is 0.
+    size_t num_columns = block.columns();
+    size_t max_threads = std::min<size_t>(context->getSettingsRef().max_insert_threads, num_columns);
+    if (max_threads > 1)
+    {
+        ThreadPool pool(max_threads);
+        for (size_t col = 0; col < num_columns; ++col)
+            pool.scheduleOrThrowOnError([&, col, thread_group = CurrentThread::getGroup()]
+            {
+                if (thread_group)
+                    CurrentThread::attachToIfDetached(thread_group);
+                split_column(col);
+            });
+        pool.wait();
+    }
+    else
+    {
+        for (size_t col = 0; col < num_columns; ++col)
+            split_column(col);
     }
 
     return result;
@@ -216,6 +660,31 @@ Block MergeTreeDataWriter::mergeBlock(
 {
     size_t block_size = block.rows();
 
+    /// There is nothing to merge in a single block in ordinary MergeTree.
+    if (merging_params.mode == MergeTreeData::MergingParams::Ordinary)
+        return block;
+
+    /// A block with at most one row cannot contain rows with equal sort keys, so for
+    /// the modes that only combine such rows the merge is an identity. This is not
+    /// true for Summing (a single row with all aggregated columns zero is dropped)
+    /// or Graphite (the time column is rounded even for a single row).
+    if (block_size <= 1
+        && (merging_params.mode == MergeTreeData::MergingParams::Replacing
+            || merging_params.mode == MergeTreeData::MergingParams::Collapsing
+            || merging_params.mode == MergeTreeData::MergingParams::VersionedCollapsing
+            || merging_params.mode == MergeTreeData::MergingParams::Aggregating))
+        return block;
+
+    /// ReplacingMergeTree only collapses rows with equal sort keys. If the block is
+    /// already sorted (no permutation is pending) and a single integer sort key is
+    /// strictly increasing, the merge is an identity - skip setting it up.
+    if (merging_params.mode == MergeTreeData::MergingParams::Replacing
+        && !permutation
+        && sort_description.size() == 1
+        && sort_description[0].direction == 1
+        && hasStrictlyIncreasingColumn(block, sort_description[0].column_name))
+        return block;
+
     auto get_merging_algorithm = [&]() -> std::shared_ptr<IMergingAlgorithm>
     {
         switch (merging_params.mode)
@@ -285,7 +754,11 @@ MergeTreeDataWriter::TemporaryPart MergeTreeDataWriter::writeTempPart(
     TemporaryPart temp_part;
     Block & block = block_with_partition.block;
 
-    auto columns = metadata_snapshot->getColumns().getAllPhysical().filter(block.getNames());
+    NameSet block_column_names;
+    for (const auto & column : block)
+        block_column_names.insert(column.name);
+
+    auto columns = metadata_snapshot->getColumns().getAllPhysical(block_column_names);
 
     for (auto & column : columns)
         if (isObject(column.type))
@@ -364,10 +837,18 @@ MergeTreeDataWriter::TemporaryPart MergeTreeDataWriter::writeTempPart(
     if (expected_size == 0)
         return temp_part;
 
+    /// Scratch block with the TTL expression results, shared by all updateTTL calls for this part.
+    Block ttl_columns_scratch;
+
     DB::IMergeTreeDataPart::TTLInfos move_ttl_infos;
     const auto & move_ttl_entries = metadata_snapshot->getMoveTTLs();
+
+    std::vector<TTLUpdateTask> move_ttl_tasks;
+    move_ttl_tasks.reserve(move_ttl_entries.size());
     for (const auto & ttl_entry : move_ttl_entries)
-        updateTTL(ttl_entry, move_ttl_infos, move_ttl_infos.moves_ttl[ttl_entry.result_column], block, false);
+        move_ttl_tasks.push_back({&ttl_entry, &move_ttl_infos.moves_ttl[ttl_entry.result_column], false});
+
+    updateTTLs(move_ttl_tasks, move_ttl_infos, block, ttl_columns_scratch);
 
     ReservationPtr reservation = data.reserveSpacePreferringTTLRules(metadata_snapshot, expected_size, move_ttl_infos, time(nullptr), 0, true);
     VolumePtr volume = data.getStoragePolicy()->getVolume(0);
@@ -396,7 +877,10 @@ MergeTreeDataWriter::TemporaryPart MergeTreeDataWriter::writeTempPart(
 
     SerializationInfo::Settings settings{data_settings->ratio_of_defaults_for_sparse_serialization, true};
     SerializationInfoByName infos(columns, settings);
-    infos.add(block);
+    /// Counting default values walks every value of every column - skip it
+    /// if no column supports sparse serialization anyway.
+    if (!infos.empty())
+        infos.add(block);
 
     new_data_part->setColumns(columns, infos);
     new_data_part->rows_count = block.rows();
@@ -412,8 +896,14 @@ MergeTreeDataWriter::TemporaryPart MergeTreeDataWriter::writeTempPart(
 
         if (new_data_part->data_part_storage->exists())
         {
-            LOG_WARNING(log, "Removing old temporary directory {}", full_path);
-            data_part_storage_builder->removeRecursive();
+            /// The stale directory may be arbitrarily large and removing it recursively
+            /// can be slow, especially on remote disks - do not block the insert on it.
+            /// Rename the directory aside instead; directories with "tmp_" prefix are
+            /// removed in background by clearOldTemporaryDirectories.
+            String stale_dir = "tmp_delete_" + part_name + "_" + toString(UUIDHelpers::generateV4());
+            LOG_WARNING(log, "Renaming old temporary directory {} to {} to be removed in background", full_path, stale_dir);
+            const auto disk = data_part_volume->getDisk();
+            disk->moveDirectory(fs::path(data.relative_data_path) / part_dir, fs::path(data.relative_data_path) / stale_dir);
         }
 
         data_part_storage_builder->createDirectories();
@@ -425,21 +915,31 @@ MergeTreeDataWriter::TemporaryPart MergeTreeDataWriter::writeTempPart(
         }
     }
 
+    /// The TTL getters return descriptions by value - keep them alive while the tasks reference them.
+    const auto rows_ttl = metadata_snapshot->getRowsTTL();
+    const auto group_by_ttl_entries = metadata_snapshot->getGroupByTTLs();
+    const auto rows_where_ttl_entries = metadata_snapshot->getRowsWhereTTLs();
+    const auto column_ttl_entries = metadata_snapshot->getColumnTTLs();
+    const auto recompression_ttl_entries = metadata_snapshot->getRecompressionTTLs();
+
+    std::vector<TTLUpdateTask> part_ttl_tasks;
+
     if (metadata_snapshot->hasRowsTTL())
-        updateTTL(metadata_snapshot->getRowsTTL(), new_data_part->ttl_infos, new_data_part->ttl_infos.table_ttl, block, true);
+        part_ttl_tasks.push_back({&rows_ttl, &new_data_part->ttl_infos.table_ttl, true});
 
-    for (const auto & ttl_entry : metadata_snapshot->getGroupByTTLs())
-        updateTTL(ttl_entry, new_data_part->ttl_infos, new_data_part->ttl_infos.group_by_ttl[ttl_entry.result_column], block, true);
+    for (const auto & ttl_entry : group_by_ttl_entries)
+        part_ttl_tasks.push_back({&ttl_entry, &new_data_part->ttl_infos.group_by_ttl[ttl_entry.result_column], true});
 
-    for (const auto & ttl_entry : metadata_snapshot->getRowsWhereTTLs())
-        updateTTL(ttl_entry, new_data_part->ttl_infos, new_data_part->ttl_infos.rows_where_ttl[ttl_entry.result_column], block, true);
+    for (const auto & ttl_entry : rows_where_ttl_entries)
+        part_ttl_tasks.push_back({&ttl_entry, &new_data_part->ttl_infos.rows_where_ttl[ttl_entry.result_column], true});
 
-    for (const auto & [name, ttl_entry] : metadata_snapshot->getColumnTTLs())
-        updateTTL(ttl_entry, new_data_part->ttl_infos, new_data_part->ttl_infos.columns_ttl[name], block, true);
+    for (const auto & [name, ttl_entry] : column_ttl_entries)
+        part_ttl_tasks.push_back({&ttl_entry, &new_data_part->ttl_infos.columns_ttl[name], true});
 
-    const auto & recompression_ttl_entries = metadata_snapshot->getRecompressionTTLs();
     for (const auto & ttl_entry : recompression_ttl_entries)
-        updateTTL(ttl_entry, new_data_part->ttl_infos, new_data_part->ttl_infos.recompression_ttl[ttl_entry.result_column], block, false);
+        part_ttl_tasks.push_back({&ttl_entry, &new_data_part->ttl_infos.recompression_ttl[ttl_entry.result_column], false});
+
+    updateTTLs(part_ttl_tasks, new_data_part->ttl_infos, block, ttl_columns_scratch);
 
     new_data_part->ttl_infos.update(move_ttl_infos);
 
@@ -476,8 +976,10 @@ MergeTreeDataWriter::TemporaryPart MergeTreeDataWriter::writeTempPart(
     temp_part.builder = data_part_storage_builder;
     temp_part.streams.emplace_back(TemporaryPart::Stream{.stream = std::move(out), .finalizer = std::move(finalizer)});
 
+    /// The block has not changed since expected_size was calculated,
+    /// no need to walk all columns computing byte sizes again.
     ProfileEvents::increment(ProfileEvents::MergeTreeDataWriterRows, block.rows());
-    ProfileEvents::increment(ProfileEvents::MergeTreeDataWriterUncompressedBytes, block.bytes());
+    ProfileEvents::increment(ProfileEvents::MergeTreeDataWriterUncompressedBytes, expected_size);
     ProfileEvents::increment(ProfileEvents::MergeTreeDataWriterCompressedBytes, new_data_part->getBytesOnDisk());
 
     return temp_part;
@@ -519,10 +1021,17 @@ MergeTreeDataWriter::TemporaryPart MergeTreeDataWriter::writeProjectionPartImpl(
     auto projection_part_storage_builder = data_part_storage_builder->getProjection(relative_path);
     new_data_part->is_temp = is_temp;
 
-    NamesAndTypesList columns = metadata_snapshot->getColumns().getAllPhysical().filter(block.getNames());
+    NameSet block_column_names;
+    for (const auto & column : block)
+        block_column_names.insert(column.name);
+
+    NamesAndTypesList columns = metadata_snapshot->getColumns().getAllPhysical(block_column_names);
     SerializationInfo::Settings settings{data.getSettings()->ratio_of_defaults_for_sparse_serialization, true};
     SerializationInfoByName infos(columns, settings);
-    infos.add(block);
+    /// Counting default values walks every value of every column - skip it
+    /// if no column supports sparse serialization anyway.
+    if (!infos.empty())
+        infos.add(block);
 
     new_data_part->setColumns(columns, infos);
 
@@ -441,6 +441,28 @@ NamesAndTypesList MergeTreePartition::executePartitionByExpression(const Storage
     return adjusted_partition_key.sample_block.getNamesAndTypesList();
 }
 
+Columns MergeTreePartition::executePartitionByExpressionGetColumns(const StorageMetadataPtr & metadata_snapshot, const Block & block, ContextPtr context)
+{
+    auto adjusted_partition_key = adjustPartitionKey(metadata_snapshot, context);
+
+    /// Execute the expression on a block with only the required columns,
+    /// so that the passed block does not have to be copied as a whole.
+    Block block_copy;
+    for (const auto & column_name : adjusted_partition_key.expression->getRequiredColumns())
+        block_copy.insert(block.getByName(column_name));
+
+    /// Keep number of rows for const expression.
+    size_t num_rows = block.rows();
+    adjusted_partition_key.expression->execute(block_copy, num_rows);
+
+    Columns partition_columns;
+    partition_columns.reserve(adjusted_partition_key.sample_block.columns());
+    for (const auto & element : adjusted_partition_key.sample_block)
+        partition_columns.emplace_back(block_copy.getByName(element.name).column);
+
+    return partition_columns;
+}
+
 KeyDescription MergeTreePartition::adjustPartitionKey(const StorageMetadataPtr & metadata_snapshot, ContextPtr context)
 {
     const auto & partition_key = metadata_snapshot->getPartitionKey();
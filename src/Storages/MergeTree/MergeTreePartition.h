@@ -56,6 +56,10 @@ public:
     /// Adjust partition key and execute its expression on block. Return sample block according to used expression.
     static NamesAndTypesList executePartitionByExpression(const StorageMetadataPtr & metadata_snapshot, Block & block, ContextPtr context);
 
+    /// The same as above, but does not mutate the passed block: the expression is executed
+    /// on a copy with only the required columns. Returns the resulting partition key columns.
+    static Columns executePartitionByExpressionGetColumns(const StorageMetadataPtr & metadata_snapshot, const Block & block, ContextPtr context);
+
     /// Make a modified partition key with substitution from modulo to moduloLegacy. Used in paritionPruner.
     static KeyDescription adjustPartitionKey(const StorageMetadataPtr & metadata_snapshot, ContextPtr context);
 };
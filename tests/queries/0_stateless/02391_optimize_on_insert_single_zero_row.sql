@@ -0,0 +1,21 @@
+DROP TABLE IF EXISTS summing_single_row;
+
+CREATE TABLE summing_single_row (key UInt32, val UInt32)
+ENGINE=SummingMergeTree(val)
+ORDER BY key;
+
+SET optimize_on_insert = 1;
+
+-- A single row with all aggregated columns zero must be collapsed away on insert,
+-- so no part is created for it.
+INSERT INTO summing_single_row VALUES (1, 0);
+
+SELECT * FROM summing_single_row ORDER BY key;
+SELECT count() FROM system.parts WHERE table = 'summing_single_row' AND database = currentDatabase() AND active = 1;
+
+INSERT INTO summing_single_row VALUES (2, 3);
+
+SELECT * FROM summing_single_row ORDER BY key;
+SELECT count() FROM system.parts WHERE table = 'summing_single_row' AND database = currentDatabase() AND active = 1;
+
+DROP TABLE IF EXISTS summing_single_row;